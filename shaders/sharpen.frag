@@ -0,0 +1,41 @@
+#version 330
+in vec2 fragTexCoord; // Fragment input attribute: texture coordinate
+in vec4 fragColor;    // Fragment input attribute: color
+out vec4 finalColor;  // Fragment output: color
+uniform sampler2D texture0;
+uniform vec4 colDiffuse;
+
+/*
+   Unsharp mask over the 4 direct neighbours.
+   Meant to be chained after a smoothing filter, at the same resolution.
+   Transparent neighbours don't count, to avoid dark halos around the sprite.
+*/
+
+uniform float SharpenStrength = 0.5;
+
+vec4 fetch(ivec2 coords, ivec2 texSize)
+{
+    return texelFetch(texture0, clamp(coords, ivec2(0), texSize - 1), 0);
+}
+
+void main()
+{
+    ivec2 texSize = textureSize(texture0, 0);
+    ivec2 centerCoords = ivec2(fragTexCoord * vec2(texSize));
+    vec4 center = fetch(centerCoords, texSize);
+
+    vec4 n = fetch(centerCoords + ivec2(0, -1), texSize);
+    vec4 s = fetch(centerCoords + ivec2(0, 1), texSize);
+    vec4 e = fetch(centerCoords + ivec2(1, 0), texSize);
+    vec4 w = fetch(centerCoords + ivec2(-1, 0), texSize);
+
+    float weight = n.a + s.a + e.a + w.a;
+    vec3 blurred = center.rgb;
+    if (weight > 0.0)
+    {
+        blurred = (n.rgb * n.a + s.rgb * s.a + e.rgb * e.a + w.rgb * w.a) / weight;
+    }
+
+    vec3 sharpened = center.rgb + (center.rgb - blurred) * SharpenStrength;
+    finalColor = vec4(clamp(sharpened, 0.0, 1.0), center.a);
+}
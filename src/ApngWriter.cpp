@@ -0,0 +1,282 @@
+#include "ApngWriter.h"
+
+#include <array>
+#include <cstring>
+
+static const uint8_t pngSignature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+
+static const std::array<uint32_t, 256> crcTable = [] {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t n = 0; n < 256; ++n)
+    {
+        uint32_t c = n;
+        for (int k = 0; k < 8; ++k)
+        {
+            c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        }
+        table[n] = c;
+    }
+    return table;
+}();
+
+static uint32_t updateCrc(uint32_t crc, const uint8_t *data, size_t size)
+{
+    for (size_t i = 0; i < size; ++i)
+    {
+        crc = crcTable[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+static uint32_t adler32(const uint8_t *data, size_t size)
+{
+    // Largest block size for which the sums can't overflow before the modulo.
+    constexpr size_t blockSize = 5552;
+    uint32_t a = 1;
+    uint32_t b = 0;
+    while (size > 0)
+    {
+        size_t blockLength = size < blockSize ? size : blockSize;
+        size -= blockLength;
+        for (size_t i = 0; i < blockLength; ++i)
+        {
+            a += *data++;
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+    }
+    return (b << 16) | a;
+}
+
+static void appendU32(std::vector<uint8_t> &buffer, uint32_t value)
+{
+    buffer.push_back(uint8_t(value >> 24));
+    buffer.push_back(uint8_t(value >> 16));
+    buffer.push_back(uint8_t(value >> 8));
+    buffer.push_back(uint8_t(value));
+}
+
+static void appendU16(std::vector<uint8_t> &buffer, uint16_t value)
+{
+    buffer.push_back(uint8_t(value >> 8));
+    buffer.push_back(uint8_t(value));
+}
+
+ApngWriter::~ApngWriter()
+{
+    close();
+}
+
+bool ApngWriter::open(const std::string &newPath, uint32_t newWidth, uint32_t newHeight)
+{
+    close();
+
+    file = std::fopen(newPath.c_str(), "wb");
+    if (file == nullptr)
+    {
+        TraceLog(LOG_WARNING, "APNG: Couldn't open %s for writing", newPath.c_str());
+        return false;
+    }
+
+    path = newPath;
+    width = newWidth;
+    height = newHeight;
+    numFrames = 0;
+    sequenceNumber = 0;
+    failed = false;
+
+    std::fwrite(pngSignature, 1, sizeof(pngSignature), file);
+
+    chunkData.clear();
+    appendU32(chunkData, width);
+    appendU32(chunkData, height);
+    chunkData.push_back(8); // Bit depth
+    chunkData.push_back(6); // Color type: RGBA
+    chunkData.push_back(0); // Compression: deflate
+    chunkData.push_back(0); // Filter method: adaptive
+    chunkData.push_back(0); // No interlacing
+    writeChunk("IHDR", chunkData);
+
+    // The frame count is a placeholder, patched in close().
+    animationControlOffset = std::ftell(file);
+    chunkData.clear();
+    appendU32(chunkData, 0); // Number of frames
+    appendU32(chunkData, 0); // Loop forever
+    writeChunk("acTL", chunkData);
+
+    return !failed;
+}
+
+bool ApngWriter::writeFrame(const Color *pixels, uint32_t delayMs)
+{
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    // The delay is a fraction stored on two 16-bit values, fall back to centiseconds
+    // for the (rare) frames that stay on screen for more than a minute.
+    uint16_t delayNumerator;
+    uint16_t delayDenominator;
+    if (delayMs <= 0xFFFF)
+    {
+        delayNumerator = uint16_t(delayMs);
+        delayDenominator = 1000;
+    }
+    else
+    {
+        uint32_t centiseconds = delayMs / 10;
+        delayNumerator = uint16_t(centiseconds <= 0xFFFF ? centiseconds : 0xFFFF);
+        delayDenominator = 100;
+    }
+
+    chunkData.clear();
+    appendU32(chunkData, sequenceNumber++);
+    appendU32(chunkData, width);
+    appendU32(chunkData, height);
+    appendU32(chunkData, 0); // X offset
+    appendU32(chunkData, 0); // Y offset
+    appendU16(chunkData, delayNumerator);
+    appendU16(chunkData, delayDenominator);
+    chunkData.push_back(0); // Dispose op: none
+    chunkData.push_back(0); // Blend op: source
+    writeChunk("fcTL", chunkData);
+
+    chunkData.clear();
+    // The first frame doubles as the default image shown by non-APNG-aware viewers.
+    if (numFrames > 0)
+    {
+        appendU32(chunkData, sequenceNumber++);
+    }
+    if (!compressFrame(pixels, chunkData))
+    {
+        failed = true;
+        return false;
+    }
+    writeChunk(numFrames == 0 ? "IDAT" : "fdAT", chunkData);
+
+    ++numFrames;
+    return !failed;
+}
+
+bool ApngWriter::close()
+{
+    if (file == nullptr)
+    {
+        return true;
+    }
+
+    chunkData.clear();
+    writeChunk("IEND", chunkData);
+
+    if (std::fseek(file, animationControlOffset, SEEK_SET) == 0)
+    {
+        chunkData.clear();
+        appendU32(chunkData, numFrames);
+        appendU32(chunkData, 0);
+        writeChunk("acTL", chunkData);
+    }
+    else
+    {
+        failed = true;
+    }
+
+    failed |= std::fclose(file) != 0;
+    file = nullptr;
+
+    if (failed)
+    {
+        TraceLog(LOG_WARNING, "APNG: Errors happened while writing %s", path.c_str());
+    }
+    else
+    {
+        TraceLog(LOG_INFO, "APNG: Wrote %u frames to %s", numFrames, path.c_str());
+    }
+    return !failed;
+}
+
+bool ApngWriter::isOpen() const
+{
+    return file != nullptr;
+}
+
+uint32_t ApngWriter::getWidth() const
+{
+    return width;
+}
+
+uint32_t ApngWriter::getHeight() const
+{
+    return height;
+}
+
+void ApngWriter::writeChunk(const char type[4], const std::vector<uint8_t> &data)
+{
+    uint8_t header[8];
+    uint32_t length = uint32_t(data.size());
+    header[0] = uint8_t(length >> 24);
+    header[1] = uint8_t(length >> 16);
+    header[2] = uint8_t(length >> 8);
+    header[3] = uint8_t(length);
+    std::memcpy(header + 4, type, 4);
+
+    uint32_t crc = updateCrc(0xFFFFFFFFu, header + 4, 4);
+    crc = updateCrc(crc, data.data(), data.size()) ^ 0xFFFFFFFFu;
+    uint8_t footer[4] = {
+        uint8_t(crc >> 24),
+        uint8_t(crc >> 16),
+        uint8_t(crc >> 8),
+        uint8_t(crc),
+    };
+
+    bool written = std::fwrite(header, 1, sizeof(header), file) == sizeof(header);
+    written &= std::fwrite(data.data(), 1, data.size(), file) == data.size();
+    written &= std::fwrite(footer, 1, sizeof(footer), file) == sizeof(footer);
+    failed |= !written;
+}
+
+bool ApngWriter::compressFrame(const Color *pixels, std::vector<uint8_t> &output)
+{
+    // Every row uses the "Up" filter: upscaled pixel art is mostly made of repeated rows,
+    // which turn into runs of zeroes that deflate very well.
+    const size_t rowSize = size_t(width) * 4;
+    filteredRows.resize((rowSize + 1) * height);
+    const uint8_t *bytes = reinterpret_cast<const uint8_t *>(pixels);
+    uint8_t *filtered = filteredRows.data();
+    for (uint32_t y = 0; y < height; ++y)
+    {
+        const uint8_t *row = bytes + y * rowSize;
+        *filtered++ = 2; // Filter type: Up
+        if (y == 0)
+        {
+            std::memcpy(filtered, row, rowSize);
+        }
+        else
+        {
+            const uint8_t *previousRow = row - rowSize;
+            for (size_t x = 0; x < rowSize; ++x)
+            {
+                filtered[x] = uint8_t(row[x] - previousRow[x]);
+            }
+        }
+        filtered += rowSize;
+    }
+
+    // raylib only produces a raw deflate stream, PNG wants it wrapped in a zlib container.
+    int compressedSize = 0;
+    unsigned char *compressed =
+        CompressData(filteredRows.data(), int(filteredRows.size()), &compressedSize);
+    if (compressed == nullptr || compressedSize <= 0)
+    {
+        MemFree(compressed);
+        return false;
+    }
+
+    output.push_back(0x78); // Deflate, 32K window
+    output.push_back(0x01); // Fastest compression level hint, valid header checksum
+    output.insert(output.end(), compressed, compressed + compressedSize);
+    appendU32(output, adler32(filteredRows.data(), filteredRows.size()));
+    MemFree(compressed);
+    return true;
+}
@@ -0,0 +1,52 @@
+#ifndef _SQUINT_APNGWRITER_H_
+#define _SQUINT_APNGWRITER_H_
+
+#include "raylib.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Minimal animated PNG encoder: RGBA8 frames of a fixed size, each with its own delay.
+// The frame count is only known once the file is closed, so the animation control chunk
+// is patched in place at that moment.
+class ApngWriter
+{
+  public:
+    ApngWriter() = default;
+    ~ApngWriter();
+
+    ApngWriter(const ApngWriter &other) = delete;
+    ApngWriter &operator=(const ApngWriter &other) = delete;
+
+    bool open(const std::string &path, uint32_t width, uint32_t height);
+
+    bool writeFrame(const Color *pixels, uint32_t delayMs);
+
+    bool close();
+
+    bool isOpen() const;
+
+    uint32_t getWidth() const;
+    uint32_t getHeight() const;
+
+  private:
+    void writeChunk(const char type[4], const std::vector<uint8_t> &data);
+    bool compressFrame(const Color *pixels, std::vector<uint8_t> &output);
+
+    std::FILE *file = nullptr;
+    std::string path;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t numFrames = 0;
+    uint32_t sequenceNumber = 0;
+    long animationControlOffset = 0;
+    bool failed = false;
+
+    // Scratch buffers kept around to avoid reallocating them for every frame.
+    std::vector<uint8_t> filteredRows;
+    std::vector<uint8_t> chunkData;
+};
+
+#endif // _SQUINT_APNGWRITER_H_
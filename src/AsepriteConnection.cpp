@@ -1,8 +1,13 @@
 #include "AsepriteConnection.h"
 
+#include "Logger.h"
+
+#include <cstring>
+
 AsepriteImage::AsepriteImage(AsepriteImage &&other) noexcept
     : width(other.width)
     , height(other.height)
+    , frameNumber(other.frameNumber)
     , pixels(std::move(other.pixels))
 {
     other.height = 0;
@@ -13,6 +18,7 @@ AsepriteImage &AsepriteImage::operator=(AsepriteImage &&other) noexcept
 {
     width = other.width;
     height = other.height;
+    frameNumber = other.frameNumber;
     pixels = std::move(other.pixels);
     other.height = 0;
     other.width = 0;
@@ -27,11 +33,22 @@ void AsepriteConnection::onMessage(std::shared_ptr<ix::ConnectionState> connecti
     switch (msg->type)
     {
     case ix::WebSocketMessageType::Close:
+        logMessage(LogLevel::Info,
+                   "NETWORK: Connection closed (%d %s)",
+                   int(msg->closeInfo.code),
+                   msg->closeInfo.reason.c_str());
         connected = false;
         break;
     case ix::WebSocketMessageType::Open:
+        setLogThreadName("network");
+        logMessage(LogLevel::Info,
+                   "NETWORK: Connection opened from %s",
+                   connectionState->getRemoteIp().c_str());
         connected = true;
         break;
+    case ix::WebSocketMessageType::Error:
+        logMessage(LogLevel::Error, "NETWORK: %s", msg->errorInfo.reason.c_str());
+        break;
     case ix::WebSocketMessageType::Message:
         if (msg->binary)
         {
@@ -42,9 +59,25 @@ void AsepriteConnection::onMessage(std::shared_ptr<ix::ConnectionState> connecti
 
             if (hdr[0] == 'I')
             {
+                uint64_t frameNumber = ++numReceivedFrames;
+                TextureStreamer *streamer = textureStreamer;
+                Color *streamedPixels = nullptr;
+                int streamBuffer =
+                    streamer != nullptr
+                        ? streamer->acquire(hdr[1], hdr[2], frameNumber, &streamedPixels)
+                        : -1;
+                if (streamBuffer >= 0)
+                {
+                    // The sprite's pixels are already laid out like Colors.
+                    std::memcpy(streamedPixels, data, size_t(hdr[1]) * size_t(hdr[2]) * 4);
+                    streamer->publish(streamBuffer);
+                    break;
+                }
+
                 AsepriteImage newImage;
                 newImage.width = hdr[1];
                 newImage.height = hdr[2];
+                newImage.frameNumber = frameNumber;
                 uint64_t dataSize = uint64_t(newImage.width) * uint64_t(newImage.height);
                 newImage.pixels.reserve(dataSize);
                 for (uint32_t i = 0; i < dataSize; ++i)
@@ -4,8 +4,10 @@
 #include "ixwebsocket/IXConnectionState.h"
 #include "ixwebsocket/IXWebSocket.h"
 #include "ixwebsocket/IXWebSocketMessageType.h"
+#include "TextureStreamer.h"
 #include "raylib.h"
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <vector>
@@ -15,6 +17,7 @@ struct AsepriteImage
 {
     uint32_t width = 0;
     uint32_t height = 0;
+    uint64_t frameNumber = 0;
     std::vector<Color> pixels{};
 
     AsepriteImage() = default;
@@ -29,6 +32,10 @@ struct AsepriteConnection
     mutable std::mutex lastReadyImageMutex;
     AsepriteImage lastReadyImage;
     bool connected = false;
+    // Frames are decoded straight into the streamer's buffers when one is available,
+    // into lastReadyImage otherwise.
+    std::atomic<TextureStreamer *> textureStreamer{nullptr};
+    std::atomic<uint64_t> numReceivedFrames{0};
 
     void onMessage(std::shared_ptr<ix::ConnectionState> connectionState,
                    ix::WebSocket &webSocket,
@@ -0,0 +1,218 @@
+#include "FilterChain.h"
+
+#include <cstdlib>
+#include <sstream>
+
+FilterChain::FilterChain(std::string name)
+    : name(std::move(name))
+{
+}
+
+void FilterChain::addPass(std::unique_ptr<Upscaler> upscaler, int scale)
+{
+    passes.push_back(Pass{std::move(upscaler), scale});
+}
+
+const std::string &FilterChain::getName() const
+{
+    return name;
+}
+
+size_t FilterChain::getNumPasses() const
+{
+    return passes.size();
+}
+
+Upscaler &FilterChain::getPass(size_t index)
+{
+    return *passes[index].upscaler;
+}
+
+void FilterChain::getPassSize(size_t index,
+                              int sourceWidth,
+                              int sourceHeight,
+                              int outputWidth,
+                              int outputHeight,
+                              int &width,
+                              int &height) const
+{
+    if (index + 1 >= passes.size())
+    {
+        width = outputWidth;
+        height = outputHeight;
+        return;
+    }
+
+    width = sourceWidth;
+    height = sourceHeight;
+    for (size_t i = 0; i <= index; ++i)
+    {
+        if (passes[i].scale == outputScale)
+        {
+            width = outputWidth;
+            height = outputHeight;
+        }
+        else
+        {
+            width *= passes[i].scale;
+            height *= passes[i].scale;
+        }
+    }
+}
+
+int FilterChain::getTextWidth() const
+{
+    int maxTextWidth = 0;
+    for (const Pass &pass : passes)
+    {
+        int textWidth = pass.upscaler->getTextWidth();
+        if (textWidth > maxTextWidth)
+        {
+            maxTextWidth = textWidth;
+        }
+    }
+
+    return maxTextWidth;
+}
+
+size_t FilterChain::getNumUniforms() const
+{
+    size_t numUniforms = 0;
+    for (const Pass &pass : passes)
+    {
+        numUniforms += pass.upscaler->getNumUniforms();
+    }
+
+    return numUniforms;
+}
+
+int FilterChain::drawSettings(float x, float y)
+{
+    int firstChangedPass = -1;
+    for (size_t i = 0; i < passes.size(); ++i)
+    {
+        if (passes[i].upscaler->drawSettings(x, y) && firstChangedPass < 0)
+        {
+            firstChangedPass = int(i);
+        }
+        y += 32.f * passes[i].upscaler->getNumUniforms();
+    }
+
+    return firstChangedPass;
+}
+
+std::vector<FilterChain> loadFilterChains(const char *path)
+{
+    using Uniform = Upscaler::Uniform;
+
+    std::vector<FilterChain> chains;
+    chains.emplace_back("- None -");
+
+    char *text = LoadFileText(path);
+    if (text == nullptr)
+    {
+        TraceLog(LOG_WARNING, "FILTERS: Couldn't read %s", path);
+        return chains;
+    }
+    std::istringstream lines(text);
+    UnloadFileText(text);
+
+    std::string line;
+    int lineNumber = 0;
+    bool inChain = false;
+    while (std::getline(lines, line))
+    {
+        ++lineNumber;
+        size_t start = line.find_first_not_of(" \t\r");
+        if (start == std::string::npos || line[start] == '#')
+        {
+            continue;
+        }
+        line = line.substr(start, line.find_last_not_of(" \t\r") + 1 - start);
+
+        if (line[0] == '[')
+        {
+            size_t end = line.find(']');
+            if (end == std::string::npos || end == 1)
+            {
+                TraceLog(LOG_WARNING, "FILTERS: %s:%d: Invalid chain name", path, lineNumber);
+                inChain = false;
+                continue;
+            }
+            chains.emplace_back(line.substr(1, end - 1));
+            inChain = true;
+            continue;
+        }
+
+        if (!inChain)
+        {
+            TraceLog(LOG_WARNING, "FILTERS: %s:%d: Line outside of a chain", path, lineNumber);
+            continue;
+        }
+
+        FilterChain &chain = chains.back();
+        std::istringstream words(line);
+        std::string keyword;
+        words >> keyword;
+        if (keyword == "pass")
+        {
+            std::string shaderPath;
+            std::string scaleText;
+            words >> shaderPath >> scaleText;
+            int scale = 1;
+            if (scaleText == "output")
+            {
+                scale = FilterChain::outputScale;
+            }
+            else if (!scaleText.empty())
+            {
+                scale = std::atoi(scaleText.c_str());
+                if (scale < 1)
+                {
+                    TraceLog(LOG_WARNING, "FILTERS: %s:%d: Invalid scale", path, lineNumber);
+                    scale = 1;
+                }
+            }
+            chain.addPass(std::make_unique<Upscaler>(shaderPath.c_str()), scale);
+        }
+        else if (keyword == "uniform")
+        {
+            std::string type;
+            Uniform uniform{};
+            words >> type >> uniform.uniformName >> uniform.value >> uniform.min >> uniform.max;
+            std::getline(words >> std::ws, uniform.name);
+            if (words.fail() || chain.getNumPasses() == 0 || (type != "int" && type != "float"))
+            {
+                TraceLog(LOG_WARNING, "FILTERS: %s:%d: Invalid uniform", path, lineNumber);
+                continue;
+            }
+            uniform.type = type == "int" ? Uniform::Type::Int : Uniform::Type::Float;
+            chain.getPass(chain.getNumPasses() - 1).addUniform(uniform);
+        }
+        else
+        {
+            TraceLog(LOG_WARNING,
+                     "FILTERS: %s:%d: Unknown keyword '%s'",
+                     path,
+                     lineNumber,
+                     keyword.c_str());
+        }
+    }
+
+    return chains;
+}
+
+std::string getFilterChainNames(const std::vector<FilterChain> &chains)
+{
+    std::string names;
+    for (const FilterChain &chain : chains)
+    {
+        if (!names.empty())
+        {
+            names += ';';
+        }
+        names += chain.getName();
+    }
+
+    return names;
+}
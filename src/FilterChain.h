@@ -0,0 +1,64 @@
+#ifndef _SQUINT_FILTERCHAIN_H_
+#define _SQUINT_FILTERCHAIN_H_
+
+#include "Upscaler.h"
+#include "raylib.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+// A sequence of shader passes, each one feeding the next. Intermediate passes scale their
+// input by an integer factor or render at the output's size, the last one always renders at
+// the output's size.
+// A chain without any pass is the plain nearest-neighbour scale.
+class FilterChain
+{
+  public:
+    // Scale of the passes rendering at the output's size.
+    static constexpr int outputScale = 0;
+
+    struct Pass
+    {
+        std::unique_ptr<Upscaler> upscaler;
+        int scale;
+    };
+
+    explicit FilterChain(std::string name);
+
+    void addPass(std::unique_ptr<Upscaler> upscaler, int scale);
+
+    const std::string &getName() const;
+
+    size_t getNumPasses() const;
+
+    Upscaler &getPass(size_t index);
+
+    // Size of a pass' output for a given source and final output size.
+    void getPassSize(size_t index,
+                     int sourceWidth,
+                     int sourceHeight,
+                     int outputWidth,
+                     int outputHeight,
+                     int &width,
+                     int &height) const;
+
+    int getTextWidth() const;
+
+    size_t getNumUniforms() const;
+
+    // Returns the index of the first pass whose settings changed, -1 if none did.
+    int drawSettings(float x, float y);
+
+  private:
+    std::string name;
+    std::vector<Pass> passes;
+};
+
+// Reads the chains listed in a filter file. The nearest-neighbour chain always comes first.
+std::vector<FilterChain> loadFilterChains(const char *path);
+
+// The names of the chains, in the format expected by raygui's dropdowns.
+std::string getFilterChainNames(const std::vector<FilterChain> &chains);
+
+#endif // _SQUINT_FILTERCHAIN_H_
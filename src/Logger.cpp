@@ -0,0 +1,347 @@
+#include "Logger.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <thread>
+
+static constexpr size_t ringSize = 1024; // Must be a power of two.
+static constexpr size_t messageSize = 256;
+static constexpr size_t threadNameSize = 16;
+static constexpr auto idleFlushDelay = std::chrono::milliseconds(10);
+
+// Slots of a bounded multi-producer queue (D. Vyukov's design): the sequence number tells
+// whether the slot is free for the producer at a given position or ready for the consumer.
+struct Slot
+{
+    std::atomic<size_t> sequence{0};
+    LogLevel level = LogLevel::Info;
+    int64_t timestampUs = 0;
+    char threadName[threadNameSize]{};
+    char text[messageSize]{};
+    // Messages that don't fit in the slot (shader compilation logs, mostly) are moved to
+    // the heap instead of being cut.
+    char *longText = nullptr;
+};
+
+struct LoggerState
+{
+    std::array<Slot, ringSize> ring;
+    std::atomic<size_t> enqueuePosition{0};
+    size_t dequeuePosition = 0;
+
+    std::atomic<bool> running{false};
+    std::atomic<int> minimumLevel{int(LogLevel::Info)};
+    std::atomic<uint64_t> numDroppedMessages{0};
+    std::atomic<uint32_t> numThreads{0};
+
+    // Flusher-side state.
+    std::thread flusher;
+    std::FILE *file = nullptr;
+    std::string path;
+    size_t fileSize = 0;
+    size_t maxFileSize = 0;
+    int maxRotatedFiles = 0;
+    uint64_t numReportedDrops = 0;
+};
+
+static LoggerState state;
+static thread_local char currentThreadName[threadNameSize]{};
+
+static const char *levelName(LogLevel level)
+{
+    switch (level)
+    {
+    case LogLevel::Trace:
+        return "TRACE";
+    case LogLevel::Debug:
+        return "DEBUG";
+    case LogLevel::Info:
+        return "INFO ";
+    case LogLevel::Warning:
+        return "WARN ";
+    case LogLevel::Error:
+        return "ERROR";
+    case LogLevel::Fatal:
+        return "FATAL";
+    }
+    return "?????";
+}
+
+static const char *threadName()
+{
+    if (currentThreadName[0] == '\0')
+    {
+        std::snprintf(currentThreadName,
+                      threadNameSize,
+                      "thread %u",
+                      unsigned(state.numThreads.fetch_add(1, std::memory_order_relaxed)));
+    }
+    return currentThreadName;
+}
+
+static void toLocalTime(std::time_t time, std::tm &result)
+{
+#if defined(_WIN32) || defined(_WIN64)
+    localtime_s(&result, &time);
+#else
+    localtime_r(&time, &result);
+#endif
+}
+
+static void rotateFiles()
+{
+    std::fclose(state.file);
+    for (int i = state.maxRotatedFiles; i >= 1; --i)
+    {
+        std::string from = i == 1 ? state.path : state.path + "." + std::to_string(i - 1);
+        std::string to = state.path + "." + std::to_string(i);
+        std::remove(to.c_str());
+        std::rename(from.c_str(), to.c_str());
+    }
+    state.file = std::fopen(state.path.c_str(), "w");
+    state.fileSize = 0;
+}
+
+static void writeLine(LogLevel level, int64_t timestampUs, const char *thread, const char *text)
+{
+    if (state.file == nullptr)
+    {
+        return;
+    }
+
+    std::time_t seconds = std::time_t(timestampUs / 1000000);
+    std::tm localTime{};
+    toLocalTime(seconds, localTime);
+    char date[32];
+    std::strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S", &localTime);
+
+    int written = std::fprintf(state.file,
+                               "%s.%03d %s [%s] %s\n",
+                               date,
+                               int((timestampUs / 1000) % 1000),
+                               levelName(level),
+                               thread,
+                               text);
+    if (written > 0)
+    {
+        state.fileSize += size_t(written);
+    }
+
+    if (state.maxFileSize > 0 && state.fileSize >= state.maxFileSize)
+    {
+        rotateFiles();
+    }
+}
+
+static int64_t now()
+{
+    using namespace std::chrono;
+    return duration_cast<microseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+// Returns false if there was nothing to write.
+static bool drainRing()
+{
+    bool wroteSomething = false;
+    while (true)
+    {
+        Slot &slot = state.ring[state.dequeuePosition & (ringSize - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != state.dequeuePosition + 1)
+        {
+            break;
+        }
+
+        writeLine(slot.level,
+                  slot.timestampUs,
+                  slot.threadName,
+                  slot.longText != nullptr ? slot.longText : slot.text);
+        std::free(slot.longText);
+        slot.longText = nullptr;
+        slot.sequence.store(state.dequeuePosition + ringSize, std::memory_order_release);
+        ++state.dequeuePosition;
+        wroteSomething = true;
+    }
+
+    uint64_t numDrops = state.numDroppedMessages.load(std::memory_order_relaxed);
+    if (numDrops != state.numReportedDrops)
+    {
+        char text[64];
+        std::snprintf(text,
+                      sizeof(text),
+                      "%llu messages dropped, the log ring was full",
+                      (unsigned long long)(numDrops - state.numReportedDrops));
+        writeLine(LogLevel::Warning, now(), "logger", text);
+        state.numReportedDrops = numDrops;
+        wroteSomething = true;
+    }
+
+    return wroteSomething;
+}
+
+static void flusherLoop()
+{
+    while (true)
+    {
+        // Read the flag before draining so that messages logged right before stopping
+        // still get written.
+        bool stillRunning = state.running.load(std::memory_order_acquire);
+        if (drainRing())
+        {
+            continue;
+        }
+
+        if (state.file != nullptr)
+        {
+            std::fflush(state.file);
+        }
+        if (!stillRunning)
+        {
+            break;
+        }
+        std::this_thread::sleep_for(idleFlushDelay);
+    }
+}
+
+bool startLogger(const char *path, size_t maxFileSize, int maxRotatedFiles)
+{
+    if (state.running)
+    {
+        return true;
+    }
+
+    state.file = std::fopen(path, "a");
+    if (state.file == nullptr)
+    {
+        return false;
+    }
+    std::fseek(state.file, 0, SEEK_END);
+    long currentSize = std::ftell(state.file);
+    state.fileSize = currentSize > 0 ? size_t(currentSize) : 0;
+    state.path = path;
+    state.maxFileSize = maxFileSize;
+    state.maxRotatedFiles = maxRotatedFiles;
+
+    for (size_t i = 0; i < ringSize; ++i)
+    {
+        state.ring[i].sequence.store(i, std::memory_order_relaxed);
+        std::free(state.ring[i].longText);
+        state.ring[i].longText = nullptr;
+    }
+    state.enqueuePosition.store(0, std::memory_order_relaxed);
+    state.dequeuePosition = 0;
+    state.numDroppedMessages = 0;
+    state.numReportedDrops = 0;
+
+    state.running.store(true, std::memory_order_release);
+    state.flusher = std::thread(flusherLoop);
+    return true;
+}
+
+void stopLogger()
+{
+    if (!state.running)
+    {
+        return;
+    }
+
+    state.running.store(false, std::memory_order_release);
+    state.flusher.join();
+    if (state.file != nullptr)
+    {
+        std::fclose(state.file);
+        state.file = nullptr;
+    }
+}
+
+void setLogLevel(LogLevel minimumLevel)
+{
+    state.minimumLevel = int(minimumLevel);
+}
+
+void setLogThreadName(const char *name)
+{
+    std::snprintf(currentThreadName, threadNameSize, "%s", name);
+}
+
+void logMessage(LogLevel level, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    logMessageV(level, format, args);
+    va_end(args);
+}
+
+void logMessageV(LogLevel level, const char *format, va_list args)
+{
+    if (int(level) < state.minimumLevel.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    if (!state.running.load(std::memory_order_acquire))
+    {
+        std::fprintf(stderr, "%s [%s] ", levelName(level), threadName());
+        std::vfprintf(stderr, format, args);
+        std::fputc('\n', stderr);
+        return;
+    }
+
+    size_t position = state.enqueuePosition.load(std::memory_order_relaxed);
+    Slot *slot;
+    while (true)
+    {
+        slot = &state.ring[position & (ringSize - 1)];
+        size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        intptr_t difference = intptr_t(sequence) - intptr_t(position);
+        if (difference == 0)
+        {
+            if (state.enqueuePosition.compare_exchange_weak(
+                    position, position + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (difference < 0)
+        {
+            // The flusher is lagging behind, don't wait for it.
+            state.numDroppedMessages.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        else
+        {
+            position = state.enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->level = level;
+    slot->timestampUs = now();
+    std::memcpy(slot->threadName, threadName(), threadNameSize);
+    va_list retryArgs;
+    va_copy(retryArgs, args);
+    int length = std::vsnprintf(slot->text, messageSize, format, args);
+    if (length >= int(messageSize))
+    {
+        slot->longText = static_cast<char *>(std::malloc(size_t(length) + 1));
+        if (slot->longText != nullptr)
+        {
+            std::vsnprintf(slot->longText, size_t(length) + 1, format, retryArgs);
+        }
+        else
+        {
+            std::memcpy(slot->text + messageSize - 4, "...", 4);
+        }
+    }
+    va_end(retryArgs);
+    slot->sequence.store(position + 1, std::memory_order_release);
+}
+
+uint64_t getNumDroppedLogMessages()
+{
+    return state.numDroppedMessages;
+}
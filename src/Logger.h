@@ -0,0 +1,42 @@
+#ifndef _SQUINT_LOGGER_H_
+#define _SQUINT_LOGGER_H_
+
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+
+// Asynchronous logger.
+// Any thread can log: the message is formatted into a slot of a lock-free ring buffer and
+// a background thread takes care of writing it to the disk. Messages too long for a slot
+// are kept whole on the heap. When the ring is full, messages are dropped (and counted)
+// rather than blocking the caller.
+
+enum class LogLevel
+{
+    Trace,
+    Debug,
+    Info,
+    Warning,
+    Error,
+    Fatal,
+};
+
+// Log files are rotated once they reach maxFileSize, keeping up to maxRotatedFiles old
+// ones next to the current one (`path.1` being the most recent).
+bool startLogger(const char *path, size_t maxFileSize, int maxRotatedFiles);
+
+// Writes the messages still in the ring and stops the background thread.
+void stopLogger();
+
+void setLogLevel(LogLevel minimumLevel);
+
+// Names the calling thread in the log lines. Unnamed threads get a number instead.
+void setLogThreadName(const char *name);
+
+void logMessage(LogLevel level, const char *format, ...);
+
+void logMessageV(LogLevel level, const char *format, va_list args);
+
+uint64_t getNumDroppedLogMessages();
+
+#endif // _SQUINT_LOGGER_H_
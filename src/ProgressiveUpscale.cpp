@@ -0,0 +1,201 @@
+#include "ProgressiveUpscale.h"
+
+#include <limits>
+
+ProgressiveUpscale::ProgressiveUpscale(int pixelsPerStep)
+    : pixelsPerStep(pixelsPerStep)
+{
+}
+
+void ProgressiveUpscale::start(FilterChain &newChain,
+                               Texture2D newSource,
+                               RenderTexture2D newTarget,
+                               RenderTexturePool &newPool)
+{
+    if (pool != nullptr && pool != &newPool)
+    {
+        releaseIntermediates();
+    }
+
+    chain = &newChain;
+    pool = &newPool;
+    source = newSource;
+    target = newTarget;
+    resizeIntermediates();
+
+    currentPass = 0;
+    numCompletedPasses = 0;
+    nextRow = 0;
+    running = true;
+}
+
+void ProgressiveUpscale::restartFrom(int pass)
+{
+    if (chain == nullptr || pass < 0 || size_t(pass) >= chain->getNumPasses())
+    {
+        return;
+    }
+
+    // An earlier pass still in progress will get to this one anyway.
+    if (running && currentPass < size_t(pass))
+    {
+        return;
+    }
+
+    currentPass = size_t(pass) < numCompletedPasses ? size_t(pass) : numCompletedPasses;
+    numCompletedPasses = currentPass;
+    nextRow = 0;
+    running = true;
+}
+
+void ProgressiveUpscale::retarget(RenderTexture2D newTarget)
+{
+    target = newTarget;
+    running = false;
+    numCompletedPasses = 0;
+    if (chain != nullptr)
+    {
+        resizeIntermediates();
+    }
+}
+
+void ProgressiveUpscale::resizeIntermediates()
+{
+    // Every pass but the last one needs an intermediate target.
+    size_t numIntermediates = chain->getNumPasses() > 0 ? chain->getNumPasses() - 1 : 0;
+    while (intermediates.size() > numIntermediates)
+    {
+        pool->release(intermediates.back());
+        intermediates.pop_back();
+    }
+    intermediates.resize(numIntermediates, RenderTexture2D{});
+    for (size_t i = 0; i < numIntermediates; ++i)
+    {
+        int width;
+        int height;
+        chain->getPassSize(i,
+                           source.width,
+                           source.height,
+                           target.texture.width,
+                           target.texture.height,
+                           width,
+                           height);
+        RenderTexture2D &intermediate = intermediates[i];
+        if (intermediate.texture.width != width || intermediate.texture.height != height)
+        {
+            pool->release(intermediate);
+            intermediate = pool->acquire(width, height);
+        }
+    }
+}
+
+void ProgressiveUpscale::cancel()
+{
+    running = false;
+}
+
+bool ProgressiveUpscale::step()
+{
+    return advance(pixelsPerStep);
+}
+
+void ProgressiveUpscale::finish()
+{
+    advance(std::numeric_limits<int64_t>::max());
+}
+
+bool ProgressiveUpscale::isRunning() const
+{
+    return running;
+}
+
+bool ProgressiveUpscale::fitsInOneStep() const
+{
+    return getRemainingPixels() <= pixelsPerStep;
+}
+
+void ProgressiveUpscale::releaseIntermediates()
+{
+    for (RenderTexture2D &intermediate : intermediates)
+    {
+        pool->release(intermediate);
+    }
+    intermediates.clear();
+    running = false;
+    chain = nullptr;
+}
+
+bool ProgressiveUpscale::advance(int64_t pixelBudget)
+{
+    if (!running)
+    {
+        return false;
+    }
+
+    if (chain->getNumPasses() == 0)
+    {
+        drawNearestNeighbour(source, target);
+        numCompletedPasses = 0;
+        running = false;
+        return true;
+    }
+
+    while (pixelBudget > 0)
+    {
+        RenderTexture2D output = getPassOutput(currentPass);
+        Texture2D input = currentPass == 0 ? source : intermediates[currentPass - 1].texture;
+        int width = output.texture.width > 0 ? output.texture.width : 1;
+        int height = output.texture.height;
+
+        int64_t numRows = pixelBudget / width;
+        if (numRows < 1)
+        {
+            numRows = 1;
+        }
+        if (numRows > height - nextRow)
+        {
+            numRows = height - nextRow;
+        }
+
+        chain->getPass(currentPass).drawRows(input, output, nextRow, int(numRows));
+        nextRow += int(numRows);
+        pixelBudget -= numRows * width;
+
+        if (nextRow >= height)
+        {
+            nextRow = 0;
+            ++currentPass;
+            numCompletedPasses = currentPass;
+            if (currentPass == chain->getNumPasses())
+            {
+                running = false;
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+int64_t ProgressiveUpscale::getRemainingPixels() const
+{
+    if (!running || chain->getNumPasses() == 0)
+    {
+        return 0;
+    }
+
+    int64_t remainingPixels = 0;
+    for (size_t pass = currentPass; pass < chain->getNumPasses(); ++pass)
+    {
+        RenderTexture2D output = getPassOutput(pass);
+        int64_t numRows = output.texture.height - (pass == currentPass ? nextRow : 0);
+        remainingPixels += numRows * output.texture.width;
+    }
+
+    return remainingPixels;
+}
+
+RenderTexture2D ProgressiveUpscale::getPassOutput(size_t pass) const
+{
+    return pass < intermediates.size() ? intermediates[pass] : target;
+}
@@ -0,0 +1,70 @@
+#ifndef _SQUINT_PROGRESSIVEUPSCALE_H_
+#define _SQUINT_PROGRESSIVEUPSCALE_H_
+
+#include "FilterChain.h"
+#include "RenderTexturePool.h"
+#include "raylib.h"
+
+#include <cstdint>
+#include <vector>
+
+// Renders a filter chain into a target, spread over several frames one band of rows at a
+// time so that a huge canvas or a slow filter never holds the render loop for long.
+// The intermediate targets are kept between runs, which allows re-rendering only the passes
+// after a changed setting.
+class ProgressiveUpscale
+{
+  public:
+    // The budget is the number of output pixels rendered per step, all passes included.
+    explicit ProgressiveUpscale(int pixelsPerStep);
+
+    // Starts over from the first pass, dropping whatever was in progress.
+    void start(FilterChain &chain,
+               Texture2D source,
+               RenderTexture2D target,
+               RenderTexturePool &pool);
+
+    // Re-renders the passes from the given one onwards, keeping the earlier results.
+    void restartFrom(int pass);
+
+    // Switches to another target, for instance when the visible scale changed. Nothing is
+    // rendered until the next start, and the earlier results aren't kept anymore.
+    void retarget(RenderTexture2D target);
+
+    void cancel();
+
+    // Renders the next band. Returns true when this step completed the target.
+    bool step();
+
+    // Renders everything left in one go.
+    void finish();
+
+    bool isRunning() const;
+
+    // Whether what's left to render fits in a single step's budget.
+    bool fitsInOneStep() const;
+
+    // Gives the intermediate targets back to the pool. Cancels the rendering.
+    void releaseIntermediates();
+
+  private:
+    // Returns true if the target got completed.
+    bool advance(int64_t pixelBudget);
+    void resizeIntermediates();
+    int64_t getRemainingPixels() const;
+    RenderTexture2D getPassOutput(size_t pass) const;
+
+    int pixelsPerStep;
+    FilterChain *chain = nullptr;
+    RenderTexturePool *pool = nullptr;
+    Texture2D source{};
+    RenderTexture2D target{};
+    std::vector<RenderTexture2D> intermediates;
+    size_t currentPass = 0;
+    // Passes whose output is up to date.
+    size_t numCompletedPasses = 0;
+    int nextRow = 0;
+    bool running = false;
+};
+
+#endif // _SQUINT_PROGRESSIVEUPSCALE_H_
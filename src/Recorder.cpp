@@ -0,0 +1,234 @@
+#include "Recorder.h"
+
+#include "Logger.h"
+
+#include <cmath>
+#include <cstring>
+#include <ctime>
+
+Recorder::Recorder(size_t maxQueuedBytes)
+    : maxQueuedBytes(maxQueuedBytes)
+    , worker([this] { workerLoop(); })
+{
+}
+
+Recorder::~Recorder()
+{
+    stop();
+    {
+        std::scoped_lock queueLock(queueMutex);
+        quitting = true;
+    }
+    queueCondition.notify_one();
+    worker.join();
+}
+
+void Recorder::start()
+{
+    if (recording)
+    {
+        return;
+    }
+
+    numCapturedFrames = 0;
+    numDroppedFrames = 0;
+    droppingFrames = false;
+    ++session;
+    recording = true;
+    TraceLog(LOG_INFO, "RECORDER: Recording started");
+}
+
+void Recorder::stop()
+{
+    if (!recording)
+    {
+        return;
+    }
+
+    recording = false;
+    {
+        std::scoped_lock queueLock(queueMutex);
+        queue.push_back(Entry{Image{}, GetTime(), true, session});
+    }
+    queueCondition.notify_one();
+    TraceLog(LOG_INFO,
+             "RECORDER: Recording stopped, %llu frames captured, %llu dropped",
+             (unsigned long long)numCapturedFrames.load(),
+             (unsigned long long)numDroppedFrames.load());
+}
+
+bool Recorder::isRecording() const
+{
+    return recording;
+}
+
+void Recorder::capture(Texture2D texture)
+{
+    if (!recording || texture.id == 0)
+    {
+        return;
+    }
+
+    // Reserve the room in the queue before reading the texture back so that a full queue
+    // costs nothing to the render thread.
+    size_t frameBytes = size_t(texture.width) * size_t(texture.height) * 4;
+    {
+        std::scoped_lock queueLock(queueMutex);
+        if (queuedBytes + frameBytes > maxQueuedBytes)
+        {
+            ++numDroppedFrames;
+            if (!droppingFrames)
+            {
+                TraceLog(LOG_WARNING, "RECORDER: Encoder can't keep up, dropping frames");
+                droppingFrames = true;
+            }
+            return;
+        }
+        queuedBytes += frameBytes;
+        droppingFrames = false;
+    }
+
+    double timestamp = GetTime();
+    Image image = LoadImageFromTexture(texture);
+
+    std::scoped_lock queueLock(queueMutex);
+    if (image.data == nullptr || image.format != PIXELFORMAT_UNCOMPRESSED_R8G8B8A8)
+    {
+        UnloadImage(image);
+        queuedBytes -= frameBytes;
+        ++numDroppedFrames;
+        return;
+    }
+    queue.push_back(Entry{image, timestamp, false, session});
+    ++numCapturedFrames;
+    queueCondition.notify_one();
+}
+
+uint64_t Recorder::getNumCapturedFrames() const
+{
+    return numCapturedFrames;
+}
+
+uint64_t Recorder::getNumDroppedFrames() const
+{
+    return numDroppedFrames;
+}
+
+void Recorder::workerLoop()
+{
+    setLogThreadName("recorder");
+    while (true)
+    {
+        Entry entry;
+        {
+            std::unique_lock queueLock(queueMutex);
+            queueCondition.wait(queueLock, [this] { return quitting || !queue.empty(); });
+            if (queue.empty())
+            {
+                break;
+            }
+            entry = queue.front();
+            queue.pop_front();
+            queuedBytes -= size_t(entry.image.width) * size_t(entry.image.height) * 4;
+        }
+
+        if (entry.session == failedSession)
+        {
+            UnloadImage(entry.image);
+            continue;
+        }
+
+        if (entry.endOfRecording)
+        {
+            writePending(entry.timestamp);
+            writer.close();
+            numFileParts = 0;
+            continue;
+        }
+
+        bool sizeMismatch = entry.image.width != pendingImage.width ||
+                            entry.image.height != pendingImage.height;
+        if (pendingImage.data != nullptr)
+        {
+            // Identical frames are merged into the previous one, which stays on screen
+            // longer.
+            if (!sizeMismatch &&
+                std::memcmp(entry.image.data,
+                            pendingImage.data,
+                            size_t(entry.image.width) * size_t(entry.image.height) * 4) == 0)
+            {
+                UnloadImage(entry.image);
+                continue;
+            }
+            writePending(entry.timestamp);
+        }
+
+        // APNG frames can't be bigger than the first one, a resized canvas gets a new file.
+        if (!writer.isOpen() || writer.getWidth() != uint32_t(entry.image.width) ||
+            writer.getHeight() != uint32_t(entry.image.height))
+        {
+            if (!openNextFile(entry.image.width, entry.image.height))
+            {
+                // Retrying for every frame would only fail the same way.
+                TraceLog(LOG_WARNING, "RECORDER: Recording stopped, couldn't create its file");
+                failedSession = entry.session;
+                recording = false;
+                numFileParts = 0;
+                UnloadImage(entry.image);
+                continue;
+            }
+        }
+
+        pendingImage = entry.image;
+        pendingTimestamp = entry.timestamp;
+    }
+
+    discardPending();
+    writer.close();
+}
+
+bool Recorder::openNextFile(uint32_t width, uint32_t height)
+{
+    if (numFileParts == 0)
+    {
+        char buffer[64];
+        std::time_t now = std::time(nullptr);
+        std::strftime(buffer, sizeof(buffer), "recording-%Y%m%d-%H%M%S", std::localtime(&now));
+        sessionName = buffer;
+
+        // Recordings started within the same second mustn't overwrite each other.
+        for (int i = 2; FileExists((sessionName + ".png").c_str()); ++i)
+        {
+            sessionName = std::string(buffer) + "_" + std::to_string(i);
+        }
+    }
+
+    ++numFileParts;
+    std::string path = sessionName;
+    if (numFileParts > 1)
+    {
+        path += "-" + std::to_string(numFileParts);
+    }
+    path += ".png";
+
+    return writer.open(path, width, height);
+}
+
+void Recorder::writePending(double nextTimestamp)
+{
+    if (pendingImage.data == nullptr)
+    {
+        return;
+    }
+
+    double duration = nextTimestamp - pendingTimestamp;
+    uint32_t delayMs = duration > 0. ? uint32_t(std::lround(duration * 1000.)) : 0;
+    writer.writeFrame(static_cast<const Color *>(pendingImage.data), delayMs);
+    discardPending();
+}
+
+void Recorder::discardPending()
+{
+    UnloadImage(pendingImage);
+    pendingImage = Image{};
+}
@@ -0,0 +1,82 @@
+#ifndef _SQUINT_RECORDER_H_
+#define _SQUINT_RECORDER_H_
+
+#include "ApngWriter.h"
+#include "raylib.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Records the upscaled results into animated PNGs.
+// The render thread only reads the texture back and queues it, the encoding happens on a
+// worker thread. The queue is bounded: when it's full, frames are dropped (and counted)
+// instead of stalling the render loop.
+class Recorder
+{
+  public:
+    explicit Recorder(size_t maxQueuedBytes = size_t(256) * 1024 * 1024);
+    ~Recorder();
+
+    Recorder(const Recorder &other) = delete;
+    Recorder &operator=(const Recorder &other) = delete;
+
+    void start();
+
+    void stop();
+
+    bool isRecording() const;
+
+    // To call when the texture's content changed. Timestamps are taken from GetTime().
+    void capture(Texture2D texture);
+
+    uint64_t getNumCapturedFrames() const;
+    uint64_t getNumDroppedFrames() const;
+
+  private:
+    struct Entry
+    {
+        Image image;
+        double timestamp;
+        // Marks the end of a recording, the image is empty.
+        bool endOfRecording;
+        uint32_t session;
+    };
+
+    void workerLoop();
+    bool openNextFile(uint32_t width, uint32_t height);
+    void writePending(double nextTimestamp);
+    void discardPending();
+
+    const size_t maxQueuedBytes;
+
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    std::deque<Entry> queue;
+    size_t queuedBytes = 0;
+    bool quitting = false;
+
+    std::atomic<bool> recording{false};
+    std::atomic<uint32_t> session{0};
+    std::atomic<uint64_t> numCapturedFrames{0};
+    std::atomic<uint64_t> numDroppedFrames{0};
+    bool droppingFrames = false;
+
+    // Worker-side state. The last frame is held until the next distinct one arrives as its
+    // duration isn't known before that.
+    ApngWriter writer;
+    Image pendingImage{};
+    double pendingTimestamp = 0.;
+    std::string sessionName;
+    int numFileParts = 0;
+    // Frames of a session whose file couldn't be opened are discarded.
+    uint32_t failedSession = 0;
+
+    std::thread worker;
+};
+
+#endif // _SQUINT_RECORDER_H_
@@ -0,0 +1,41 @@
+#include "RenderTexturePool.h"
+
+RenderTexturePool::~RenderTexturePool()
+{
+    trim();
+}
+
+RenderTexture2D RenderTexturePool::acquire(int width, int height)
+{
+    for (size_t i = 0; i < freeTargets.size(); ++i)
+    {
+        RenderTexture2D target = freeTargets[i];
+        if (target.texture.width == width && target.texture.height == height)
+        {
+            freeTargets[i] = freeTargets.back();
+            freeTargets.pop_back();
+            return target;
+        }
+    }
+
+    RenderTexture2D target = LoadRenderTexture(width, height);
+    SetTextureFilter(target.texture, TEXTURE_FILTER_POINT);
+    return target;
+}
+
+void RenderTexturePool::release(RenderTexture2D target)
+{
+    if (target.id != 0)
+    {
+        freeTargets.push_back(target);
+    }
+}
+
+void RenderTexturePool::trim()
+{
+    for (RenderTexture2D &target : freeTargets)
+    {
+        UnloadRenderTexture(target);
+    }
+    freeTargets.clear();
+}
@@ -0,0 +1,32 @@
+#ifndef _SQUINT_RENDERTEXTUREPOOL_H_
+#define _SQUINT_RENDERTEXTUREPOOL_H_
+
+#include "raylib.h"
+
+#include <cstddef>
+#include <vector>
+
+// Keeps released render textures around so that the intermediate targets of the filter
+// chains aren't reallocated every frame.
+class RenderTexturePool
+{
+  public:
+    RenderTexturePool() = default;
+    ~RenderTexturePool();
+
+    RenderTexturePool(const RenderTexturePool &other) = delete;
+    RenderTexturePool &operator=(const RenderTexturePool &other) = delete;
+
+    // Returns a point-filtered target of the given size, recycled if possible.
+    RenderTexture2D acquire(int width, int height);
+
+    void release(RenderTexture2D target);
+
+    // Unloads the targets currently unused.
+    void trim();
+
+  private:
+    std::vector<RenderTexture2D> freeTargets;
+};
+
+#endif // _SQUINT_RENDERTEXTUREPOOL_H_
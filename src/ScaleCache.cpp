@@ -0,0 +1,215 @@
+#include "ScaleCache.h"
+
+ScaleCache::ScaleCache(RenderTexturePool &pool, int pixelsPerStep, size_t memoryBudget)
+    : pool(pool)
+    , job(pixelsPerStep)
+    , memoryBudget(memoryBudget)
+{
+}
+
+void ScaleCache::setEnabled(bool newEnabled)
+{
+    if (enabled && !newEnabled)
+    {
+        unload();
+    }
+    enabled = newEnabled;
+}
+
+bool ScaleCache::isEnabled() const
+{
+    return enabled;
+}
+
+void ScaleCache::reset(FilterChain &newChain, Texture2D newSource, int newVisibleScale)
+{
+    stopJob();
+    if (chain != &newChain)
+    {
+        // The intermediates are kept for the next frames, unless they belong to another
+        // chain.
+        job.releaseIntermediates();
+    }
+
+    bool sourceResized = newSource.width != source.width || newSource.height != source.height;
+    chain = &newChain;
+    source = newSource;
+    visibleScale = newVisibleScale;
+
+    ScaleList scheduledScales = getScheduledScales();
+    for (int scale = minScale; scale <= maxScale; ++scale)
+    {
+        Entry &entry = getEntry(scale);
+        entry.complete = false;
+
+        bool scheduled = false;
+        for (int scheduledScale : scheduledScales)
+        {
+            scheduled |= scheduledScale == scale;
+        }
+        if (sourceResized || !scheduled)
+        {
+            pool.release(entry.target);
+            entry.target = RenderTexture2D{};
+        }
+    }
+}
+
+void ScaleCache::invalidate()
+{
+    stopJob();
+    for (Entry &entry : entries)
+    {
+        entry.complete = false;
+    }
+}
+
+void ScaleCache::step()
+{
+    if (!enabled || chain == nullptr || source.id == 0)
+    {
+        return;
+    }
+
+    if (jobScale == 0)
+    {
+        for (int scale : getScheduledScales())
+        {
+            if (scale == 0)
+            {
+                break;
+            }
+
+            Entry &entry = getEntry(scale);
+            if (entry.complete)
+            {
+                continue;
+            }
+
+            if (entry.target.id == 0)
+            {
+                entry.target = pool.acquire(source.width * scale, source.height * scale);
+            }
+            job.start(*chain, source, entry.target, pool);
+            jobScale = scale;
+            break;
+        }
+    }
+
+    if (jobScale != 0 && job.step())
+    {
+        getEntry(jobScale).complete = true;
+        stopJob();
+    }
+}
+
+bool ScaleCache::swap(int scale, RenderTexture2D &visibleTarget, bool visibleComplete)
+{
+    if (!enabled || scale < minScale || scale > maxScale || scale == visibleScale)
+    {
+        return false;
+    }
+
+    Entry &entry = getEntry(scale);
+    if (!entry.complete)
+    {
+        return false;
+    }
+
+    if (visibleScale >= minScale && visibleScale <= maxScale)
+    {
+        Entry &previous = getEntry(visibleScale);
+        pool.release(previous.target);
+        previous.target = visibleTarget;
+        previous.complete = visibleComplete && visibleTarget.id != 0;
+    }
+    else
+    {
+        pool.release(visibleTarget);
+    }
+
+    visibleTarget = entry.target;
+    entry.target = RenderTexture2D{};
+    entry.complete = false;
+
+    // The budget follows the visible scale, what doesn't fit anymore has to go.
+    if (jobScale != 0)
+    {
+        stopJob();
+    }
+    visibleScale = scale;
+    ScaleList scheduledScales = getScheduledScales();
+    for (int otherScale = minScale; otherScale <= maxScale; ++otherScale)
+    {
+        bool scheduled = false;
+        for (int scheduledScale : scheduledScales)
+        {
+            scheduled |= scheduledScale == otherScale;
+        }
+        if (!scheduled)
+        {
+            Entry &other = getEntry(otherScale);
+            pool.release(other.target);
+            other.target = RenderTexture2D{};
+            other.complete = false;
+        }
+    }
+
+    return true;
+}
+
+void ScaleCache::unload()
+{
+    stopJob();
+    job.releaseIntermediates();
+    for (Entry &entry : entries)
+    {
+        pool.release(entry.target);
+        entry = Entry{};
+    }
+    pool.trim();
+    chain = nullptr;
+    source = Texture2D{};
+    visibleScale = 0;
+}
+
+ScaleCache::Entry &ScaleCache::getEntry(int scale)
+{
+    return entries[scale - minScale];
+}
+
+ScaleCache::ScaleList ScaleCache::getScheduledScales() const
+{
+    ScaleList scales{};
+    size_t numScales = 0;
+    size_t usedMemory = 0;
+
+    // Closest scales first, the smaller one first when two are as close.
+    for (int distance = 1; distance <= maxScale - minScale; ++distance)
+    {
+        for (int scale : {visibleScale - distance, visibleScale + distance})
+        {
+            if (scale < minScale || scale > maxScale)
+            {
+                continue;
+            }
+
+            size_t size =
+                size_t(source.width) * size_t(source.height) * size_t(scale * scale) * 4;
+            if (usedMemory + size > memoryBudget)
+            {
+                return scales;
+            }
+            usedMemory += size;
+            scales[numScales++] = scale;
+        }
+    }
+
+    return scales;
+}
+
+void ScaleCache::stopJob()
+{
+    job.cancel();
+    jobScale = 0;
+}
@@ -0,0 +1,75 @@
+#ifndef _SQUINT_SCALECACHE_H_
+#define _SQUINT_SCALECACHE_H_
+
+#include "FilterChain.h"
+#include "ProgressiveUpscale.h"
+#include "RenderTexturePool.h"
+#include "raylib.h"
+
+#include <array>
+#include <cstddef>
+
+// Renders the current frame at the scales that aren't shown, when the visible one is done,
+// so that moving the scale slider can swap the result in instead of re-rendering it.
+// The scales closest to the visible one come first and the cached targets stay within a
+// memory budget.
+class ScaleCache
+{
+  public:
+    static constexpr int minScale = 1;
+    static constexpr int maxScale = 6;
+
+    ScaleCache(RenderTexturePool &pool, int pixelsPerStep, size_t memoryBudget);
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+
+    // To call on a new frame, filter chain or visible scale, or when enabling the cache:
+    // every scale is to be re-rendered.
+    void reset(FilterChain &chain, Texture2D source, int visibleScale);
+
+    // To call when the filter's settings changed.
+    void invalidate();
+
+    // Renders the next band of the most urgent scale. Call it only when the visible scale
+    // has nothing left to do.
+    void step();
+
+    // If the given scale is ready, swaps its target with the visible one, which is kept
+    // for the previous scale (if it was complete). Returns false if the scale isn't ready.
+    bool swap(int scale, RenderTexture2D &visibleTarget, bool visibleComplete);
+
+    // Gives every target back to the pool and unloads the unused ones. The other calls
+    // leave the pool as it is, so that the next frames can reuse its targets.
+    void unload();
+
+  private:
+    struct Entry
+    {
+        RenderTexture2D target{};
+        bool complete = false;
+    };
+
+    Entry &getEntry(int scale);
+    using ScaleList = std::array<int, maxScale - minScale + 1>;
+
+    // Returns the scales in the order they should be rendered, padded with zeroes. Those
+    // that don't fit in the budget (and the visible one) aren't listed.
+    ScaleList getScheduledScales() const;
+    // Cancels the job, keeping its intermediate targets.
+    void stopJob();
+
+    RenderTexturePool &pool;
+    ProgressiveUpscale job;
+    size_t memoryBudget;
+    bool enabled = false;
+
+    std::array<Entry, maxScale - minScale + 1> entries;
+    FilterChain *chain = nullptr;
+    Texture2D source{};
+    int visibleScale = 0;
+    // Scale being rendered by the job, 0 if none.
+    int jobScale = 0;
+};
+
+#endif // _SQUINT_SCALECACHE_H_
@@ -0,0 +1,263 @@
+#include "TextureStreamer.h"
+
+#include "rlgl.h"
+
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_43)
+#define SQUINT_TEXTURE_STREAMING
+// raylib's own loader, the functions are available once the window is created.
+#include "external/glad.h"
+#endif
+
+void TextureStreamer::load()
+{
+#if defined(SQUINT_TEXTURE_STREAMING)
+    supported = glGenBuffers != nullptr && glMapBufferRange != nullptr &&
+                glUnmapBuffer != nullptr && glFenceSync != nullptr &&
+                glClientWaitSync != nullptr && glDeleteSync != nullptr;
+    if (!supported)
+    {
+        TraceLog(LOG_WARNING, "STREAMER: Pixel buffers unavailable, using regular uploads");
+        return;
+    }
+
+    std::scoped_lock buffersLock(buffersMutex);
+    for (Buffer &buffer : buffers)
+    {
+        glGenBuffers(1, &buffer.id);
+    }
+    TraceLog(LOG_INFO, "STREAMER: Streaming uploads through %d pixel buffers", int(numBuffers));
+#endif
+}
+
+void TextureStreamer::unload()
+{
+#if defined(SQUINT_TEXTURE_STREAMING)
+    if (!supported)
+    {
+        return;
+    }
+
+    std::scoped_lock buffersLock(buffersMutex);
+    for (Buffer &buffer : buffers)
+    {
+        if (buffer.pixels != nullptr)
+        {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer.id);
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        }
+        if (buffer.fence != nullptr)
+        {
+            glDeleteSync(GLsync(buffer.fence));
+        }
+        glDeleteBuffers(1, &buffer.id);
+        buffer = Buffer{};
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    supported = false;
+#endif
+}
+
+bool TextureStreamer::isSupported() const
+{
+    return supported;
+}
+
+bool TextureStreamer::update(Texture2D &texture, bool &resized, uint64_t &frameNumber)
+{
+    resized = false;
+#if defined(SQUINT_TEXTURE_STREAMING)
+    if (!supported)
+    {
+        return false;
+    }
+
+    std::scoped_lock buffersLock(buffersMutex);
+
+    // Polls the previous copies without waiting for them.
+    for (Buffer &buffer : buffers)
+    {
+        if (buffer.fence == nullptr)
+        {
+            continue;
+        }
+        GLenum status = glClientWaitSync(GLsync(buffer.fence), 0, 0);
+        if (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED)
+        {
+            glDeleteSync(GLsync(buffer.fence));
+            buffer.fence = nullptr;
+            TraceLog(LOG_DEBUG,
+                     "STREAMER: Fence of buffer %d signalled",
+                     int(&buffer - buffers.data()));
+        }
+    }
+
+    // Only the newest frame is worth uploading, the older ones can be written over.
+    Buffer *newest = nullptr;
+    for (Buffer &buffer : buffers)
+    {
+        if (buffer.state != State::Filled)
+        {
+            continue;
+        }
+        if (newest == nullptr || buffer.frameNumber > newest->frameNumber)
+        {
+            if (newest != nullptr)
+            {
+                newest->state = State::Mapped;
+            }
+            newest = &buffer;
+        }
+        else
+        {
+            buffer.state = State::Mapped;
+        }
+    }
+
+    if (newest != nullptr)
+    {
+        // Whatever raylib batched may still use the texture.
+        rlDrawRenderBatchActive();
+
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, newest->id);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        newest->pixels = nullptr;
+
+        resized = texture.width != int(newest->width) || texture.height != int(newest->height);
+        if (resized)
+        {
+            UnloadTexture(texture);
+            texture.width = int(newest->width);
+            texture.height = int(newest->height);
+            texture.mipmaps = 1;
+            texture.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+            texture.id = rlLoadTexture(
+                nullptr, texture.width, texture.height, texture.format, texture.mipmaps);
+        }
+
+        // With a pixel buffer bound, the data pointer is an offset in the buffer: the copy
+        // happens on the GPU's side.
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, newest->id);
+        glBindTexture(GL_TEXTURE_2D, texture.id);
+        glTexSubImage2D(GL_TEXTURE_2D,
+                        0,
+                        0,
+                        0,
+                        texture.width,
+                        texture.height,
+                        GL_RGBA,
+                        GL_UNSIGNED_BYTE,
+                        nullptr);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        newest->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        newest->state = State::Idle;
+        TraceLog(LOG_DEBUG,
+                 "STREAMER: Frame %llu uploaded from buffer %d, fence placed",
+                 (unsigned long long)newest->frameNumber,
+                 int(newest - buffers.data()));
+        frameNumber = newest->frameNumber;
+    }
+
+    remapIdleBuffers();
+    return newest != nullptr;
+#else
+    (void)texture;
+    (void)frameNumber;
+    return false;
+#endif
+}
+
+int TextureStreamer::acquire(uint32_t width,
+                             uint32_t height,
+                             uint64_t frameNumber,
+                             Color **pixels)
+{
+    if (!supported)
+    {
+        return -1;
+    }
+
+    size_t size = size_t(width) * size_t(height) * sizeof(Color);
+    std::scoped_lock buffersLock(buffersMutex);
+    for (size_t i = 0; i < numBuffers; ++i)
+    {
+        Buffer &buffer = buffers[i];
+        if (buffer.state == State::Mapped && buffer.capacity >= size)
+        {
+            buffer.state = State::Writing;
+            buffer.width = width;
+            buffer.height = height;
+            buffer.frameNumber = frameNumber;
+            *pixels = buffer.pixels;
+            TraceLog(LOG_DEBUG,
+                     "STREAMER: Frame %llu acquired buffer %d",
+                     (unsigned long long)frameNumber,
+                     int(i));
+            return int(i);
+        }
+    }
+
+    if (size > requestedCapacity)
+    {
+        requestedCapacity = size;
+    }
+    return -1;
+}
+
+void TextureStreamer::publish(int buffer)
+{
+    std::scoped_lock buffersLock(buffersMutex);
+    buffers[buffer].state = State::Filled;
+    TraceLog(LOG_DEBUG,
+             "STREAMER: Frame %llu published in buffer %d",
+             (unsigned long long)buffers[buffer].frameNumber,
+             buffer);
+}
+
+void TextureStreamer::remapIdleBuffers()
+{
+#if defined(SQUINT_TEXTURE_STREAMING)
+    size_t capacity = requestedCapacity;
+    if (capacity == 0)
+    {
+        return;
+    }
+
+    for (Buffer &buffer : buffers)
+    {
+        bool tooSmall = buffer.capacity < capacity;
+        bool reusable = buffer.state == State::Idle && buffer.fence == nullptr;
+        bool growable = buffer.state == State::Mapped && tooSmall;
+        if (!reusable && !growable)
+        {
+            continue;
+        }
+
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer.id);
+        if (buffer.pixels != nullptr)
+        {
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            buffer.pixels = nullptr;
+        }
+        if (tooSmall)
+        {
+            glBufferData(GL_PIXEL_UNPACK_BUFFER, GLsizeiptr(capacity), nullptr, GL_STREAM_DRAW);
+            buffer.capacity = capacity;
+        }
+        // Invalidating lets the driver hand over fresh memory instead of synchronizing.
+        buffer.pixels = static_cast<Color *>(
+            glMapBufferRange(GL_PIXEL_UNPACK_BUFFER,
+                             0,
+                             GLsizeiptr(buffer.capacity),
+                             GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+        buffer.state = buffer.pixels != nullptr ? State::Mapped : State::Idle;
+        TraceLog(LOG_DEBUG,
+                 "STREAMER: Buffer %d mapped (%zu bytes)",
+                 int(&buffer - buffers.data()),
+                 buffer.capacity);
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+#endif
+}
@@ -0,0 +1,74 @@
+#ifndef _SQUINT_TEXTURESTREAMER_H_
+#define _SQUINT_TEXTURESTREAMER_H_
+
+#include "raylib.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+// Streams frames into a texture through ping-ponged pixel buffer objects.
+// The render thread keeps the free buffers mapped so that the network thread can decode
+// the frames straight into them. Uploading is then only a GPU-side copy, and a fence keeps
+// a buffer from being reused before that copy is done, without ever waiting on it.
+// Requires OpenGL 3.3: isSupported() says whether the callers should fall back to regular
+// uploads.
+class TextureStreamer
+{
+  public:
+    TextureStreamer() = default;
+
+    TextureStreamer(const TextureStreamer &other) = delete;
+    TextureStreamer &operator=(const TextureStreamer &other) = delete;
+
+    // Render thread only, with a valid GL context.
+    void load();
+    void unload();
+    bool isSupported() const;
+
+    // Uploads the newest frame written since the last call, recreating the texture if its
+    // size changed. Returns true if the texture got a new frame. Render thread only.
+    bool update(Texture2D &texture, bool &resized, uint64_t &frameNumber);
+
+    // Returns a buffer to decode the frame into, or -1 if none is available (for instance
+    // because the frame is bigger than the buffers, which will grow for the next ones).
+    // Any thread, a buffer isn't used by the render thread until it's published.
+    int acquire(uint32_t width, uint32_t height, uint64_t frameNumber, Color **pixels);
+    void publish(int buffer);
+
+  private:
+    enum class State
+    {
+        // Unmapped, possibly still being copied from.
+        Idle,
+        // Available for writing.
+        Mapped,
+        Writing,
+        Filled,
+    };
+
+    struct Buffer
+    {
+        unsigned int id = 0;
+        size_t capacity = 0;
+        State state = State::Idle;
+        void *fence = nullptr;
+        Color *pixels = nullptr;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint64_t frameNumber = 0;
+    };
+
+    static constexpr size_t numBuffers = 2;
+
+    void remapIdleBuffers();
+
+    std::mutex buffersMutex;
+    std::array<Buffer, numBuffers> buffers;
+    std::atomic<size_t> requestedCapacity{0};
+    // Read by acquire() outside of the lock.
+    std::atomic<bool> supported{false};
+};
+
+#endif // _SQUINT_TEXTURESTREAMER_H_
@@ -35,15 +35,6 @@ Upscaler::~Upscaler()
     }
 }
 
-void Upscaler::unloadShader()
-{
-    if (shader.id != 0)
-    {
-        UnloadShader(shader);
-        shader = {};
-    }
-}
-
 void Upscaler::reload()
 {
     char *shaderText = LoadFileText(shaderPath.c_str());
@@ -56,12 +47,17 @@ void Upscaler::reload()
             UnloadShader(shader);
         }
         shader = newShader;
+        for (const Uniform &uniform : uniforms)
+        {
+            applyUniform(uniform);
+        }
     }
 }
 
 void Upscaler::addUniform(Upscaler::Uniform uniform)
 {
     uniforms.push_back(uniform);
+    applyUniform(uniform);
 }
 
 int Upscaler::getTextWidth() const
@@ -98,23 +94,8 @@ bool Upscaler::drawSettings(float x, float y)
 
         if (newValue != uniform.value)
         {
-            if (uniform.type == Uniform::Type::Float)
-            {
-                SetShaderValue(shader,
-                               GetShaderLocation(shader, uniform.uniformName.c_str()),
-                               &uniform.value,
-                               SHADER_UNIFORM_FLOAT);
-            }
-            else
-            {
-                int intValue = newValue;
-                SetShaderValue(shader,
-                               GetShaderLocation(shader, uniform.uniformName.c_str()),
-                               &intValue,
-                               SHADER_UNIFORM_INT);
-            }
-
             uniform.value = newValue;
+            applyUniform(uniform);
             changed = true;
         }
 
@@ -126,8 +107,15 @@ bool Upscaler::drawSettings(float x, float y)
 
 void Upscaler::draw(Texture2D texture, RenderTexture2D output)
 {
+    drawRows(texture, output, 0, output.texture.height);
+}
 
+void Upscaler::drawRows(Texture2D texture, RenderTexture2D output, int firstRow, int numRows)
+{
     BeginTextureMode(output);
+    // The whole quad is submitted, the scissor makes sure only the requested band is
+    // shaded.
+    BeginScissorMode(0, firstRow, output.texture.width, numRows);
     BeginShaderMode(shader);
     ClearBackground(BLANK);
     // RenderTextures in OpenGL must be flipped on the Y axis.
@@ -135,10 +123,46 @@ void Upscaler::draw(Texture2D texture, RenderTexture2D output)
     Rectangle dest{0, 0, float(output.texture.width), float(output.texture.height)};
     DrawTexturePro(texture, src, dest, {0, 0}, 0.f, WHITE);
     EndShaderMode();
+    EndScissorMode();
     EndTextureMode();
 }
 
 size_t Upscaler::getNumUniforms() const
 {
     return uniforms.size();
+}
+
+void Upscaler::applyUniform(const Uniform &uniform)
+{
+    if (shader.id == 0)
+    {
+        return;
+    }
+
+    if (uniform.type == Uniform::Type::Float)
+    {
+        SetShaderValue(shader,
+                       GetShaderLocation(shader, uniform.uniformName.c_str()),
+                       &uniform.value,
+                       SHADER_UNIFORM_FLOAT);
+    }
+    else
+    {
+        int intValue = uniform.value;
+        SetShaderValue(shader,
+                       GetShaderLocation(shader, uniform.uniformName.c_str()),
+                       &intValue,
+                       SHADER_UNIFORM_INT);
+    }
+}
+
+void drawNearestNeighbour(Texture2D texture, RenderTexture2D output)
+{
+    BeginTextureMode(output);
+    ClearBackground(BLANK);
+    // RenderTextures in OpenGL must be flipped on the Y axis.
+    Rectangle src{0, 0, float(texture.width), -float(texture.height)};
+    Rectangle dest{0, 0, float(output.texture.width), float(output.texture.height)};
+    DrawTexturePro(texture, src, dest, {0, 0}, 0.f, WHITE);
+    EndTextureMode();
 }
\ No newline at end of file
@@ -28,7 +28,8 @@ class Upscaler
     Upscaler(const char *path);
     ~Upscaler();
 
-    void unloadShader();
+    Upscaler(const Upscaler &other) = delete;
+    Upscaler &operator=(const Upscaler &other) = delete;
 
     void reload();
 
@@ -40,12 +41,21 @@ class Upscaler
 
     void draw(Texture2D texture, RenderTexture2D output);
 
+    // Only renders the rows [firstRow, firstRow + numRows) of the output.
+    void drawRows(Texture2D texture, RenderTexture2D output, int firstRow, int numRows);
+
     size_t getNumUniforms() const;
 
   private:
+    void applyUniform(const Uniform &uniform);
+
     std::vector<Uniform> uniforms;
     std::string shaderPath;
     Shader shader{};
 };
 
+// The "- None -" filter: a plain nearest-neighbour scale, relying on the textures' point
+// filtering.
+void drawNearestNeighbour(Texture2D texture, RenderTexture2D output);
+
 #endif // __SQUINT_UPSCALER_H_
\ No newline at end of file
@@ -18,12 +18,27 @@
 #endif
 
 #include "AsepriteConnection.h"
+#include "FilterChain.h"
+#include "Logger.h"
+#include "ProgressiveUpscale.h"
+#include "Recorder.h"
+#include "RenderTexturePool.h"
+#include "ScaleCache.h"
+#include "TextureStreamer.h"
 #include "Upscaler.h"
 
 #include "platformSetup.h"
 
 #include <cmath>
 #include <cstdint>
+#include <string>
+#include <vector>
+
+static const char filtersPath[] = "shaders/filters.txt";
+// Output pixels filtered per frame before falling back to the preview.
+static constexpr int pixelsPerFrame = 1024 * 1024;
+// Memory allowed for the precomputed scales.
+static constexpr size_t scaleCacheBudget = size_t(256) * 1024 * 1024;
 
 enum class UiState
 {
@@ -57,10 +72,10 @@ static void DrawTextBorder(const char *text,
 
 int start()
 {
-    using Uniform = Upscaler::Uniform;
-
     // Initialization
     //--------------------------------------------------------------------------------------
+    setLogThreadName("render");
+
     int windowWidth = 800;
     int windowHeight = 450;
 
@@ -78,7 +93,17 @@ int start()
                        const ix::WebSocketMessagePtr &msg) {
             imageServer.onMessage(connectionState, webSocket, msg);
         });
-    serv.listenAndStart();
+    auto listenResult = serv.listen();
+    if (listenResult.first)
+    {
+        serv.start();
+    }
+    else
+    {
+        logMessage(LogLevel::Error,
+                   "NETWORK: Couldn't listen on port 34613: %s",
+                   listenResult.second.c_str());
+    }
 
     // Prepare Raylib, the window, the graphics settings...
     InitWindow(windowWidth, windowHeight, "Squint live viewer");
@@ -88,43 +113,44 @@ int start()
 
     SetTargetFPS(60); // Set our game to run at 60 frames-per-second
 
+    TextureStreamer textureStreamer;
+    textureStreamer.load();
+    if (textureStreamer.isSupported())
+    {
+        imageServer.textureStreamer = &textureStreamer;
+    }
+
     Texture2D currentTexture{};
+    // Frames may come either from the streamer or from lastReadyImage, the older ones are
+    // skipped.
+    uint64_t lastUploadedFrame = 0;
+    // What the pooled targets were last needed for. They're kept across frames and only
+    // trimmed once the chain or the canvas' size changes.
+    int pooledChain = -1;
+    int pooledSourceWidth = 0;
+    int pooledSourceHeight = 0;
     RenderTexture2D upscaledTexture{};
+    // Nearest-neighbour version of the current frame, shown while the filtered one is being
+    // rendered.
+    RenderTexture2D previewTexture{};
+    ProgressiveUpscale progressiveUpscale(pixelsPerFrame);
 
-    // Prepare the shaders.
-    // xBR-lv1 (no blend version)
-    Upscaler xbrLv1("shaders/xbr-lv1.frag");
-    xbrLv1.addUniform(Uniform{Uniform::Type::Int, "Corner mode", "XbrCornerMode", 2, 0.f, 2.f});
-    xbrLv1.addUniform(
-        Uniform{Uniform::Type::Float, "Luma Weight", "XbrYWeight", 48.f, 0.f, 100.f});
-    xbrLv1.addUniform(Uniform{Uniform::Type::Float,
-                              "Color match threshold",
-                              "XbrEqThreshold",
-                              30.f,
-                              0.f,
-                              50.f});
-    // xBR-lv2 (color blending version)
-    Upscaler xbrLv2("shaders/xbr-lv2.frag");
-    xbrLv2.addUniform(Uniform{Uniform::Type::Int, "Xbr Scale", "XbrScale", 4, 0.f, 5.f});
-    xbrLv2.addUniform(Uniform{Uniform::Type::Int, "Corner mode", "XbrCornerMode", 0, 0.f, 3.f});
-    xbrLv2.addUniform(
-        Uniform{Uniform::Type::Float, "Luma Weight", "XbrYWeight", 48.f, 0.f, 100.f});
-    xbrLv2.addUniform(Uniform{Uniform::Type::Float,
-                              "Color match threshold",
-                              "XbrEqThreshold",
-                              30.f,
-                              0.f,
-                              50.f});
-    xbrLv2.addUniform(
-        Uniform{Uniform::Type::Float, "Lv 2 coefficient", "XbrLv2Coefficient", 2.f, 0.f, 3.f});
+    // Prepare the filters.
+    RenderTexturePool renderTargetPool;
+    ScaleCache scaleCache(renderTargetPool, pixelsPerFrame, scaleCacheBudget);
+    std::vector<FilterChain> filterChains = loadFilterChains(filtersPath);
+    std::string filterNames = getFilterChainNames(filterChains);
 
     int selectedUpscaler = 0;
     bool upscalerComboBoxActive = false;
     bool refreshUpscalee = false;
     bool refreshRenderTarget = false;
+    // First filter pass whose settings changed, -1 if none did.
+    int firstChangedPass = -1;
 
     bool darkBackground = false;
     bool willScreenshot = false;
+    bool willToggleRecording = false;
 
     bool previouslyConnected = false;
 
@@ -134,6 +160,8 @@ int start()
     int storedWindowHeight = 450;
     Vector2 storedWindowPostion;
 
+    Recorder recorder;
+
     //--------------------------------------------------------------------------------------
 
     // Main game loop
@@ -161,6 +189,25 @@ int start()
             willScreenshot = true;
         }
 
+        if (IsKeyPressed(KEY_R))
+        {
+            willToggleRecording = true;
+        }
+
+        if (IsKeyPressed(KEY_F5))
+        {
+            progressiveUpscale.releaseIntermediates();
+            scaleCache.unload();
+            renderTargetPool.trim();
+            filterChains = loadFilterChains(filtersPath);
+            filterNames = getFilterChainNames(filterChains);
+            if (size_t(selectedUpscaler) >= filterChains.size())
+            {
+                selectedUpscaler = 0;
+            }
+            refreshUpscalee = true;
+        }
+
         if (IsKeyPressed(KEY_F11))
         {
             fullscreenMode = !fullscreenMode;
@@ -224,9 +271,22 @@ int start()
                 currentImage.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
                 currentImage.mipmaps = 1;
 
-                if ((lastImage.width != 0 && lastImage.height != 0))
+                bool resized = false;
+                uint64_t streamedFrame = 0;
+                bool streamed = textureStreamer.isSupported() &&
+                                textureStreamer.update(currentTexture, resized, streamedFrame);
+                if (streamed)
+                {
+                    refreshUpscalee = true;
+                    refreshRenderTarget |= resized;
+                    lastUploadedFrame = streamedFrame;
+                }
+
+                bool hasImage = lastImage.width != 0 && lastImage.height != 0;
+                if (hasImage && lastImage.frameNumber > lastUploadedFrame)
                 {
                     refreshUpscalee = true;
+                    lastUploadedFrame = lastImage.frameNumber;
                     bool sizeMismatch = lastImage.width != currentTexture.width ||
                                         lastImage.height != currentTexture.height;
                     // Regenerate the base texture
@@ -241,7 +301,8 @@ int start()
                         UpdateTexture(currentTexture, currentImage.data);
                     }
                 }
-                else if (imageServer.connected && !previouslyConnected)
+                else if (!hasImage && !streamed && imageServer.connected &&
+                         !previouslyConnected)
                 {
                     // Clear the texture in case of reconnection.
                     refreshUpscalee = true;
@@ -264,6 +325,7 @@ int start()
                 if (refreshRenderTarget)
                 {
                     refreshRenderTarget = false;
+                    progressiveUpscale.cancel();
                     UnloadRenderTexture(upscaledTexture);
 
                     upscaledTexture = LoadRenderTexture(currentTexture.width * renderScale,
@@ -272,40 +334,78 @@ int start()
                     SetTextureFilter(upscaledTexture.texture, TEXTURE_FILTER_POINT);
                 }
 
+                bool restarted = false;
                 if (refreshUpscalee)
                 {
                     refreshUpscalee = false;
-                    switch (selectedUpscaler)
+                    progressiveUpscale.start(filterChains[selectedUpscaler],
+                                             currentTexture,
+                                             upscaledTexture,
+                                             renderTargetPool);
+                    scaleCache.reset(
+                        filterChains[selectedUpscaler], currentTexture, renderScale);
+                    if (pooledChain != selectedUpscaler ||
+                        pooledSourceWidth != currentTexture.width ||
+                        pooledSourceHeight != currentTexture.height)
+                    {
+                        // Whatever the previous chain or size needed isn't used anymore.
+                        renderTargetPool.trim();
+                        pooledChain = selectedUpscaler;
+                        pooledSourceWidth = currentTexture.width;
+                        pooledSourceHeight = currentTexture.height;
+                    }
+                    restarted = true;
+                }
+                else if (firstChangedPass >= 0)
+                {
+                    progressiveUpscale.restartFrom(firstChangedPass);
+                    scaleCache.invalidate();
+                    restarted = true;
+                }
+                firstChangedPass = -1;
+
+                if (restarted && progressiveUpscale.fitsInOneStep())
+                {
+                    progressiveUpscale.finish();
+                    recorder.capture(upscaledTexture.texture);
+                }
+                else
+                {
+                    // Show the new frame right away, the filtered version replaces it
+                    // once it's done. A newer frame restarts the work.
+                    if (restarted)
                     {
-                    case 0: {
-                        BeginTextureMode(upscaledTexture);
-                        ClearBackground(BLANK);
-                        // RenderTextures in OpenGL must be flipped on the Y axis.
-                        Rectangle src{0,
-                                      0,
-                                      float(currentTexture.width),
-                                      -float(currentTexture.height)};
-                        Rectangle dest{0,
-                                       0,
-                                       float(upscaledTexture.texture.width),
-                                       float(upscaledTexture.texture.height)};
-                        DrawTexturePro(currentTexture, src, dest, {0, 0}, 0.f, WHITE);
-                        EndTextureMode();
+                        // Sized here rather than with the result's target: swapping in a
+                        // precomputed scale doesn't need a preview.
+                        if (previewTexture.texture.width != upscaledTexture.texture.width ||
+                            previewTexture.texture.height != upscaledTexture.texture.height)
+                        {
+                            renderTargetPool.release(previewTexture);
+                            previewTexture = renderTargetPool.acquire(
+                                upscaledTexture.texture.width, upscaledTexture.texture.height);
+                        }
+                        drawNearestNeighbour(currentTexture, previewTexture);
                     }
-                    break;
-                    case 1:
-                        xbrLv1.draw(currentTexture, upscaledTexture);
-                        break;
-                    case 2:
-                        xbrLv2.draw(currentTexture, upscaledTexture);
-                        break;
+                    if (progressiveUpscale.isRunning())
+                    {
+                        if (progressiveUpscale.step())
+                        {
+                            recorder.capture(upscaledTexture.texture);
+                        }
+                    }
+                    else
+                    {
+                        // The visible scale is done, the other ones get the frame's budget.
+                        scaleCache.step();
                     }
                 }
 
-                Vector2 texturePosition{(windowWidth - upscaledTexture.texture.width) / 2.f,
-                                        (windowHeight - upscaledTexture.texture.height) / 2.f};
+                RenderTexture2D shownTexture =
+                    progressiveUpscale.isRunning() ? previewTexture : upscaledTexture;
+                Vector2 texturePosition{(windowWidth - shownTexture.texture.width) / 2.f,
+                                        (windowHeight - shownTexture.texture.height) / 2.f};
 
-                DrawTextureEx(upscaledTexture.texture, texturePosition, 0, 1, WHITE);
+                DrawTextureEx(shownTexture.texture, texturePosition, 0, 1, WHITE);
             }
 
             previouslyConnected = imageServer.connected;
@@ -315,19 +415,15 @@ int start()
                 int maxTextWidth = 0;
                 int numFields = 0;
                 {
-                    if (selectedUpscaler == 0)
+                    const FilterChain &selectedChain = filterChains[selectedUpscaler];
+                    if (selectedChain.getNumUniforms() == 0)
                     {
                         maxTextWidth = MeasureText("Filter", 10);
                     }
-                    else if (selectedUpscaler == 1)
-                    {
-                        maxTextWidth = xbrLv1.getTextWidth() + 32.f;
-                        numFields = xbrLv1.getNumUniforms();
-                    }
-                    else if (selectedUpscaler == 2)
+                    else
                     {
-                        maxTextWidth = xbrLv2.getTextWidth() + 32.f;
-                        numFields = xbrLv2.getNumUniforms();
+                        maxTextWidth = selectedChain.getTextWidth() + 32.f;
+                        numFields = selectedChain.getNumUniforms();
                     }
                 }
 
@@ -342,14 +438,26 @@ int start()
                 int integerScale = roundf(selectedScale);
                 if (integerScale != renderScale)
                 {
+                    bool upscaledIsComplete = !progressiveUpscale.isRunning() &&
+                                              !refreshUpscalee && firstChangedPass < 0;
+                    if (scaleCache.swap(integerScale, upscaledTexture, upscaledIsComplete))
+                    {
+                        // The result at the new scale was ready, nothing has to be
+                        // rendered.
+                        progressiveUpscale.retarget(upscaledTexture);
+                        recorder.capture(upscaledTexture.texture);
+                    }
+                    else
+                    {
+                        refreshRenderTarget = true;
+                        refreshUpscalee = true;
+                    }
                     renderScale = integerScale;
-                    refreshRenderTarget = true;
-                    refreshUpscalee = true;
                 }
 
                 int previousSelection = selectedUpscaler;
                 if (GuiDropdownBox({8, 40, 256, 20},
-                                   "- None -;XBR-lv1;XBR-lv2",
+                                   filterNames.c_str(),
                                    &selectedUpscaler,
                                    upscalerComboBoxActive))
                 {
@@ -362,14 +470,11 @@ int start()
 
                 if (!upscalerComboBoxActive)
                 {
-                    switch (selectedUpscaler)
+                    int changedPass = filterChains[selectedUpscaler].drawSettings(32, 72);
+                    if (changedPass >= 0 &&
+                        (firstChangedPass < 0 || changedPass < firstChangedPass))
                     {
-                    case 1:
-                        refreshUpscalee |= xbrLv1.drawSettings(32, 72);
-                        break;
-                    case 2:
-                        refreshUpscalee |= xbrLv2.drawSettings(32, 72);
-                        break;
+                        firstChangedPass = changedPass;
                     }
                 }
 
@@ -389,6 +494,26 @@ int start()
                     darkBackground = !darkBackground;
                 }
 
+                if (GuiButton({float(windowWidth) - 128 - 16, 72, 137, 20},
+                              recorder.isRecording() ? "Stop recording" : "Record"))
+                {
+                    willToggleRecording = true;
+                }
+
+                bool precomputeScales =
+                    GuiCheckBox({float(windowWidth) - 128 - 16, 104, 20, 20},
+                                "Precompute scales",
+                                scaleCache.isEnabled());
+                if (precomputeScales != scaleCache.isEnabled())
+                {
+                    scaleCache.setEnabled(precomputeScales);
+                    if (precomputeScales)
+                    {
+                        scaleCache.reset(
+                            filterChains[selectedUpscaler], currentTexture, renderScale);
+                    }
+                }
+
                 if (GuiButton({float(windowWidth) - 64 - 8, 8, 64, 20}, "Help!"))
                 {
                     uiState = UiState::Help;
@@ -403,6 +528,8 @@ int start()
 - F2 to toggle the background's color.
 - Right-click or TAB to toggle the options.
 - S to save the current result.
+- R to start or stop recording the results.
+- F5 to reload the filters.
 - F11 to toggle fullscreen mode.
 - F12 to screenshot.)END",
                     24,
@@ -419,12 +546,53 @@ int start()
 
             if (willScreenshot)
             {
+                if (progressiveUpscale.isRunning())
+                {
+                    progressiveUpscale.finish();
+                    recorder.capture(upscaledTexture.texture);
+                }
                 Image savedImage = LoadImageFromTexture(upscaledTexture.texture);
                 ExportImage(savedImage, "saved.png");
                 UnloadImage(savedImage);
                 willScreenshot = false;
             }
 
+            if (willToggleRecording)
+            {
+                willToggleRecording = false;
+                if (recorder.isRecording())
+                {
+                    recorder.stop();
+                }
+                else
+                {
+                    recorder.start();
+                    // What's shown is the first frame. A render in progress captures it
+                    // when it completes.
+                    if (!progressiveUpscale.isRunning())
+                    {
+                        recorder.capture(upscaledTexture.texture);
+                    }
+                }
+            }
+
+            if (recorder.isRecording())
+            {
+                const char *recordingText =
+                    TextFormat("REC - %llu frames, %llu dropped",
+                               (unsigned long long)recorder.getNumCapturedFrames(),
+                               (unsigned long long)recorder.getNumDroppedFrames());
+                DrawTextBorder(recordingText, 8, windowHeight - 18, 10, RED, BLACK);
+            }
+
+            uint64_t numDroppedLogMessages = getNumDroppedLogMessages();
+            if (numDroppedLogMessages > 0)
+            {
+                const char *droppedText = TextFormat(
+                    "%llu log messages dropped", (unsigned long long)numDroppedLogMessages);
+                DrawTextBorder(droppedText, 8, windowHeight - 32, 10, ORANGE, BLACK);
+            }
+
             EndDrawing();
         }
         //----------------------------------------------------------------------------------
@@ -432,12 +600,19 @@ int start()
 
     serv.stop();
     ix::uninitNetSystem();
+    imageServer.textureStreamer = nullptr;
+    textureStreamer.unload();
 
     // De-Initialization
     //--------------------------------------------------------------------------------------
-    // Manual shader unload to avoid crashes due to unload order.
-    xbrLv1.unloadShader();
-    xbrLv2.unloadShader();
+    // The GPU resources have to go before the window and its context. The pooled targets
+    // first, then the chains whose destructors unload the shaders.
+    progressiveUpscale.releaseIntermediates();
+    scaleCache.unload();
+    renderTargetPool.release(previewTexture);
+    renderTargetPool.trim();
+    filterChains.clear();
+    recorder.stop();
     UnloadRenderTexture(upscaledTexture);
     UnloadTexture(currentTexture);
 
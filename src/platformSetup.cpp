@@ -1,6 +1,12 @@
 #include "platformSetup.h"
 
+#include "Logger.h"
+#include "raylib.h"
+
+#include <cstdarg>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
 
 #if defined(_WIN32) || defined(_WIN64)
 #define WIN32_LEAN_AND_MEAN
@@ -8,16 +14,87 @@
 #include <wincon.h>
 #endif
 
+static constexpr size_t maxLogFileSize = 8 * 1024 * 1024;
+static constexpr int maxRotatedLogFiles = 3;
+
+// raylib reports these at the info level every time they happen, which is for every frame
+// while recording. They'd push everything else out of the rotated logs.
+static const char *const perFrameMessages[] = {
+    "TEXTURE: [ID %i] Pixel data retrieved successfully",
+    "SYSTEM: Compress data: ",
+};
+
+static bool isPerFrameMessage(const char *text)
+{
+    for (const char *message : perFrameMessages)
+    {
+        if (std::strncmp(text, message, std::strlen(message)) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void raylibLogCallback(int logLevel, const char *text, va_list args)
+{
+    LogLevel level = LogLevel::Info;
+    switch (logLevel)
+    {
+    case LOG_TRACE:
+        level = LogLevel::Trace;
+        break;
+    case LOG_DEBUG:
+        level = LogLevel::Debug;
+        break;
+    case LOG_WARNING:
+        level = LogLevel::Warning;
+        break;
+    case LOG_ERROR:
+        level = LogLevel::Error;
+        break;
+    case LOG_FATAL:
+        level = LogLevel::Fatal;
+        break;
+    default:
+        if (isPerFrameMessage(text))
+        {
+            level = LogLevel::Debug;
+        }
+        break;
+    }
+    logMessageV(level, text, args);
+
+    // raylib doesn't exit by itself when a callback is set. Flush the log first so that
+    // the reason isn't lost.
+    if (logLevel == LOG_FATAL)
+    {
+        stopLogger();
+        std::exit(EXIT_FAILURE);
+    }
+}
 
 void setupLoggingOutput()
 {
+    if (!startLogger("squint.log", maxLogFileSize, maxRotatedLogFiles))
+    {
+        puts("[ERROR] Couldn't open the log file");
+        return;
+    }
+    SetTraceLogCallback(raylibLogCallback);
+#if !defined(NDEBUG)
+    setLogLevel(LogLevel::Debug);
+    SetTraceLogLevel(LOG_DEBUG);
+#endif
 
+    // Whatever still writes to the standard outputs directly (IXWebSocket's server does
+    // for some errors) goes into its own file, as it can't share the rotated one.
     bool allAreRedirected = true;
-    allAreRedirected &= std::freopen("squint.log", "a", stdout) != nullptr;
-    allAreRedirected &= std::freopen("squint.log", "a", stderr) != nullptr;
+    allAreRedirected &= std::freopen("squint-stdio.log", "a", stdout) != nullptr;
+    allAreRedirected &= std::freopen("squint-stdio.log", "a", stderr) != nullptr;
     if (!allAreRedirected)
     {
-        puts("[ERROR] Coudln't set up the logging redirection");
+        logMessage(LogLevel::Error, "Couldn't redirect the standard outputs");
     }
     else
     {
@@ -29,6 +106,8 @@ void setupLoggingOutput()
 
 void unsetupLoggingOutput()
 {
+    SetTraceLogCallback(nullptr);
+    stopLogger();
     fflush(stdout);
     fflush(stderr);
-}
\ No newline at end of file
+}